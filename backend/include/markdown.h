@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace markdown {
+    // Renders the Markdown subset used by blog posts (headings, paragraphs,
+    // lists, blockquotes, **strong**, *em* and `code`) to HTML in time linear
+    // in the input. All text is HTML-escaped; raw HTML in the source is never
+    // passed through.
+    std::string toHtml(const std::string& source);
+
+    std::string escapeHtml(const std::string& text);
+}
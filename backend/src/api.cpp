@@ -1,5 +1,8 @@
 #include "../include/api.h"
+#include "../include/markdown.h"
+#include <cctype>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 
 namespace api {
@@ -109,21 +112,119 @@ std::string getProjectsJson() {
 ])XXX";
 }
 
+static std::string getBlogPostSource(const std::string &id);
+
 std::string getBlogPostsJson() {
-  // Use getBlogPostJson to build the list - simpler approach
+  // Build the list from the source records - the rendered html is only
+  // served on the single-post route
   std::string result = "[";
-  result += getBlogPostJson("gravitons-dont-exist");
+  result += getBlogPostSource("gravitons-dont-exist");
   result += ",";
-  result += getBlogPostJson("cosmic-livestream");
+  result += getBlogPostSource("cosmic-livestream");
   result += ",";
-  result += getBlogPostJson("time-travel-paradox");
+  result += getBlogPostSource("time-travel-paradox");
   result += ",";
-  result += getBlogPostJson("boundless-space");
+  result += getBlogPostSource("boundless-space");
   result += "]";
   return result;
 }
 
+// Extracts and unescapes the string value of `key` from a flat JSON object.
+// Returns an empty string if the key is missing.
+static std::string extractJsonString(const std::string &json,
+                                     const std::string &key) {
+  std::string needle = "\"" + key + "\":";
+  size_t pos = json.find(needle);
+  if (pos == std::string::npos) {
+    return "";
+  }
+  pos = json.find('"', pos + needle.size());
+  if (pos == std::string::npos) {
+    return "";
+  }
+
+  std::string value;
+  for (size_t i = pos + 1; i < json.size(); ++i) {
+    char c = json[i];
+    if (c == '"') {
+      break;
+    }
+    if (c != '\\' || i + 1 >= json.size()) {
+      value += c;
+      continue;
+    }
+    switch (json[++i]) {
+    case 'n':
+      value += '\n';
+      break;
+    case 'r':
+      value += '\r';
+      break;
+    case 't':
+      value += '\t';
+      break;
+    case 'b':
+      value += '\b';
+      break;
+    case 'f':
+      value += '\f';
+      break;
+    case 'u': {
+      // Only control characters are written as \u escapes by escapeJson;
+      // anything malformed is kept as-is
+      int code = 0;
+      size_t digits = 0;
+      while (digits < 4 && i + 1 + digits < json.size() &&
+             std::isxdigit(static_cast<unsigned char>(json[i + 1 + digits]))) {
+        char h = json[i + 1 + digits];
+        code = code * 16 + (std::isdigit(static_cast<unsigned char>(h))
+                                ? h - '0'
+                                : std::tolower(static_cast<unsigned char>(h)) - 'a' + 10);
+        ++digits;
+      }
+      if (digits == 4 && code < 0x80) {
+        value += static_cast<char>(code);
+        i += 4;
+      } else {
+        value += "\\u";
+      }
+      break;
+    }
+    default:
+      value += json[i];
+    }
+  }
+  return value;
+}
+
+// Rendered post JSON (source record plus an "html" field), keyed by post id.
+// Post records are compiled in, so each one is rendered on first use and a
+// new build is the only way its content changes.
+static std::map<std::string, std::string> renderedPosts;
+static std::mutex renderedPostsMutex;
+
 std::string getBlogPostJson(const std::string &id) {
+  std::lock_guard<std::mutex> lock(renderedPostsMutex);
+  auto it = renderedPosts.find(id);
+  if (it != renderedPosts.end()) {
+    return it->second;
+  }
+
+  std::string source = getBlogPostSource(id);
+  if (source == "{}") {
+    return source;
+  }
+
+  std::string content = extractJsonString(source, "content");
+  std::string json = source;
+  size_t lastField = json.find_last_not_of(" \n", json.rfind('}') - 1) + 1;
+  json.insert(lastField, ",\n  \"html\": \"" +
+                             escapeJson(markdown::toHtml(content)) + "\"");
+  renderedPosts[id] = json;
+  return json;
+}
+
+static std::string getBlogPostSource(const std::string &id) {
   if (id == "gravitons-dont-exist") {
     return R"XXX({
   "id": "gravitons-dont-exist",
@@ -0,0 +1,233 @@
+#include "fieldset.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string_view>
+
+void FieldSet::skipWhitespace(size_t& pos) {
+    while (pos < source_.size() && std::isspace(static_cast<unsigned char>(source_[pos]))) {
+        ++pos;
+    }
+}
+
+bool FieldSet::skipString(size_t& pos) {
+    // pos is on the opening quote
+    for (++pos; pos < source_.size(); ++pos) {
+        if (source_[pos] == '\\') {
+            ++pos;
+        } else if (source_[pos] == '"') {
+            ++pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FieldSet::skipValue(size_t& pos) {
+    if (pos >= source_.size()) {
+        return false;
+    }
+    if (source_[pos] == '"') {
+        return skipString(pos);
+    }
+    if (source_[pos] == '{' || source_[pos] == '[') {
+        int depth = 0;
+        while (pos < source_.size()) {
+            char c = source_[pos];
+            if (c == '"') {
+                if (!skipString(pos)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+            }
+            ++pos;
+            if (depth == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // Number, true, false or null
+    size_t start = pos;
+    while (pos < source_.size() && source_[pos] != ',' && source_[pos] != '}' &&
+           source_[pos] != ']' && !std::isspace(static_cast<unsigned char>(source_[pos]))) {
+        ++pos;
+    }
+    return pos > start;
+}
+
+bool FieldSet::parseObject(size_t& pos, std::vector<Field>& record) {
+    if (pos >= source_.size() || source_[pos] != '{') {
+        return false;
+    }
+    ++pos;
+    skipWhitespace(pos);
+    if (pos < source_.size() && source_[pos] == '}') {
+        ++pos;
+        return true;
+    }
+
+    while (pos < source_.size()) {
+        if (source_[pos] != '"') {
+            return false;
+        }
+        Field field;
+        field.nameOffset = pos + 1;
+        if (!skipString(pos)) {
+            return false;
+        }
+        field.nameLength = pos - 1 - field.nameOffset;
+
+        skipWhitespace(pos);
+        if (pos >= source_.size() || source_[pos] != ':') {
+            return false;
+        }
+        ++pos;
+        skipWhitespace(pos);
+
+        field.valueOffset = pos;
+        if (!skipValue(pos)) {
+            return false;
+        }
+        field.valueLength = pos - field.valueOffset;
+        record.push_back(field);
+
+        skipWhitespace(pos);
+        if (pos < source_.size() && source_[pos] == ',') {
+            ++pos;
+            skipWhitespace(pos);
+        } else if (pos < source_.size() && source_[pos] == '}') {
+            ++pos;
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool FieldSet::load(const std::string& json) {
+    source_ = json;
+    records_.clear();
+    names_.clear();
+
+    size_t pos = 0;
+    skipWhitespace(pos);
+    if (pos >= source_.size()) {
+        return false;
+    }
+
+    bool loaded = false;
+    isArray_ = source_[pos] == '[';
+    if (!isArray_) {
+        records_.emplace_back();
+        loaded = parseObject(pos, records_.back());
+    } else {
+        ++pos;
+        skipWhitespace(pos);
+        loaded = pos < source_.size() && source_[pos] == ']';
+        while (!loaded && pos < source_.size()) {
+            records_.emplace_back();
+            if (!parseObject(pos, records_.back())) {
+                break;
+            }
+            skipWhitespace(pos);
+            if (pos < source_.size() && source_[pos] == ',') {
+                ++pos;
+                skipWhitespace(pos);
+            } else {
+                loaded = pos < source_.size() && source_[pos] == ']';
+                break;
+            }
+        }
+    }
+    if (!loaded) {
+        return false;
+    }
+
+    for (const auto& record : records_) {
+        for (const Field& field : record) {
+            names_.push_back(source_.substr(field.nameOffset, field.nameLength));
+        }
+    }
+    std::sort(names_.begin(), names_.end());
+    names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+    return true;
+}
+
+std::vector<std::string> FieldSet::known(const std::vector<std::string>& fields) const {
+    std::vector<std::string> result;
+    std::set_intersection(fields.begin(), fields.end(), names_.begin(), names_.end(),
+                          std::back_inserter(result));
+    return result;
+}
+
+std::string FieldSet::project(const std::vector<std::string>& fields) const {
+    std::string out;
+    if (isArray_) {
+        out += '[';
+    }
+
+    std::vector<bool> emitted(fields.size());
+    for (size_t r = 0; r < records_.size(); ++r) {
+        if (r > 0) {
+            out += ',';
+        }
+        out += '{';
+        std::fill(emitted.begin(), emitted.end(), false);
+        bool first = true;
+        for (const Field& field : records_[r]) {
+            std::string_view name(source_.data() + field.nameOffset, field.nameLength);
+            auto it = std::lower_bound(fields.begin(), fields.end(), name,
+                                       [](const std::string& a, std::string_view b) { return a < b; });
+            if (it == fields.end() || *it != name || emitted[it - fields.begin()]) {
+                continue;
+            }
+            // Duplicate keys keep their first value
+            emitted[it - fields.begin()] = true;
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += '"';
+            out.append(source_, field.nameOffset, field.nameLength);
+            out += "\":";
+            out.append(source_, field.valueOffset, field.valueLength);
+        }
+        out += '}';
+    }
+
+    if (isArray_) {
+        out += ']';
+    }
+    return out;
+}
+
+bool parseFieldList(const std::string& value, std::vector<std::string>& fields) {
+    fields.clear();
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        std::string name = value.substr(start, end - start);
+        for (char c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                return false;
+            }
+        }
+        if (!name.empty()) {
+            fields.push_back(name);
+        }
+        start = end + 1;
+    }
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+    return true;
+}
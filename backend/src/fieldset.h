@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A JSON object, or array of objects, split into per-field fragments. Each
+// fragment is a slice of the already-serialized source, so a projection only
+// concatenates slices and never re-escapes or re-serializes a value.
+class FieldSet {
+public:
+    // Splits `json` into records. Returns false if it is not an object or an
+    // array of objects, in which case project() must not be used.
+    bool load(const std::string& json);
+
+    // Builds a compact document keeping only the named fields, in source
+    // order. `fields` must be sorted (see parseFieldList). Unknown names are
+    // ignored.
+    std::string project(const std::vector<std::string>& fields) const;
+
+    // The subset of `fields` (sorted) that occurs in at least one record
+    std::vector<std::string> known(const std::vector<std::string>& fields) const;
+
+    // The document passed to load(), whether or not it could be split
+    const std::string& source() const { return source_; }
+
+private:
+    struct Field {
+        size_t nameOffset;
+        size_t nameLength;
+        size_t valueOffset;
+        size_t valueLength;
+    };
+
+    std::string source_;
+    bool isArray_ = false;
+    std::vector<std::vector<Field>> records_;
+    std::vector<std::string> names_; // Sorted, distinct field names
+
+    bool parseObject(size_t& pos, std::vector<Field>& record);
+    bool skipValue(size_t& pos);
+    bool skipString(size_t& pos);
+    void skipWhitespace(size_t& pos);
+};
+
+// Normalizes a `fields` query value ("b,a,,b") into a sorted, de-duplicated
+// list ({"a", "b"}). Returns false if a name contains anything other than
+// alphanumerics and underscores.
+bool parseFieldList(const std::string& value, std::vector<std::string>& fields);
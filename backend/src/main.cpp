@@ -1,10 +1,12 @@
 #include "server.h"
+#include "trace.h"
 #include "../include/api.h"
 #include <iostream>
 #include <signal.h>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
+#include <strings.h>
 
 SimpleHTTPServer* g_server = nullptr;
 
@@ -16,15 +18,79 @@ void signalHandler(int signum) {
     exit(signum);
 }
 
+// Reads an integer setting from the environment, falling back to `fallback`
+int envInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::atoi(value) : fallback;
+}
+
+// Reads a boolean setting ("1"/"true"/"yes") from the environment
+bool envFlag(const char* name, bool fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    return std::strcmp(value, "1") == 0 || strcasecmp(value, "true") == 0 || strcasecmp(value, "yes") == 0;
+}
+
+void traceDumpHandler(int) {
+    trace::requestDump();
+}
+
 int main() {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
+    // SIGUSR1 writes buffered trace spans to TRACE_FILE. No SA_RESTART, so the
+    // signal wakes the accept loop and the dump happens right away; reads and
+    // writes it interrupts during a request are retried by the server.
+    struct sigaction dump_action = {};
+    dump_action.sa_handler = traceDumpHandler;
+    sigemptyset(&dump_action.sa_mask);
+    sigaction(SIGUSR1, &dump_action, nullptr);
+    
+    // TRACE_SAMPLE=N records one request in N (0 or unset: tracing off).
+    // Can be changed at runtime through /admin/trace.
+    int trace_sample = envInt("TRACE_SAMPLE", 0);
+    trace::setSampleRate(trace_sample > 0 ? trace_sample : 1);
+    trace::setEnabled(trace_sample > 0);
+    const char* trace_file_env = std::getenv("TRACE_FILE");
+    if (trace_file_env && *trace_file_env) {
+        trace::setDumpPath(trace_file_env);
+    }
+    
     // Read PORT from environment variable (Railway provides this)
     const char* port_env = std::getenv("PORT");
     int port = port_env ? std::atoi(port_env) : 8080;
     
-    SimpleHTTPServer server(port);
+    // Listener tuning. UNIX_SOCKET switches to an AF_UNIX listener for a
+    // proxy on the same host, in which case the TCP settings are ignored.
+    ListenerOptions listener;
+    const char* unix_socket_env = std::getenv("UNIX_SOCKET");
+    const char* bind_address_env = std::getenv("BIND_ADDRESS");
+    listener.unixSocketPath = unix_socket_env ? unix_socket_env : "";
+    const char* unix_socket_mode_env = std::getenv("UNIX_SOCKET_MODE");
+    if (unix_socket_mode_env && *unix_socket_mode_env) {
+        listener.unixSocketMode = static_cast<unsigned>(std::strtoul(unix_socket_mode_env, nullptr, 8));
+    }
+    listener.bindAddress = bind_address_env ? bind_address_env : "";
+    listener.ipv6 = envFlag("LISTEN_IPV6", false);
+    listener.ipv6Only = envFlag("LISTEN_IPV6_ONLY", false);
+    listener.backlog = envInt("LISTEN_BACKLOG", listener.backlog);
+    listener.tcpNoDelay = envFlag("TCP_NODELAY", false);
+    listener.deferAcceptSeconds = envInt("TCP_DEFER_ACCEPT", 0);
+    listener.fastOpenQueue = envInt("TCP_FASTOPEN", 0);
+    listener.clientTimeoutSeconds = envInt("CLIENT_TIMEOUT", listener.clientTimeoutSeconds);
+    
+    // TLS_CERT and TLS_KEY enable TLS termination in the server itself
+    const char* tls_cert_env = std::getenv("TLS_CERT");
+    const char* tls_key_env = std::getenv("TLS_KEY");
+    listener.tlsCertFile = tls_cert_env ? tls_cert_env : "";
+    listener.tlsKeyFile = tls_key_env ? tls_key_env : "";
+    listener.kernelTls = envFlag("TLS_KTLS", true);
+    listener.tlsTicketRotationSeconds = envInt("TLS_TICKET_ROTATION", listener.tlsTicketRotationSeconds);
+    
+    SimpleHTTPServer server(port, listener);
     g_server = &server;
     
     // API Routes
@@ -48,18 +114,29 @@ int main() {
         return api::getWorkExperienceJson();
     });
     
+    // Everything the landing page needs in a single round trip
+    server.addCompositeRoute("/api/bootstrap", {
+        {"personal", "/api/personal"},
+        {"projects", "/api/projects"},
+        {"workExperience", "/api/work-experience"},
+        {"blog", "/api/blog?fields=id,title,excerpt,date,category"},
+    });
+    
     server.addRouteWithParam("/api/games/:id/leaderboard", [](const std::string& id) {
         return api::getLeaderboardJson(id);
     });
     
     std::cout << "Starting Portfolio Server..." << std::endl;
     std::cout << "API Endpoints:" << std::endl;
+    std::cout << "  GET /api/bootstrap" << std::endl;
     std::cout << "  GET /api/personal" << std::endl;
     std::cout << "  GET /api/projects" << std::endl;
     std::cout << "  GET /api/blog" << std::endl;
     std::cout << "  GET /api/blog/:id" << std::endl;
     std::cout << "  GET /api/work-experience" << std::endl;
     std::cout << "  GET /api/games/:id/leaderboard" << std::endl;
+    std::cout << "  GET /admin/trace (requires ADMIN_TOKEN)" << std::endl;
+    std::cout << "  (append ?fields=a,b,c to any GET route for a sparse fieldset)" << std::endl;
     std::cout << std::endl;
     
     server.start();
@@ -0,0 +1,349 @@
+#include "../include/markdown.h"
+#include <cctype>
+#include <vector>
+
+namespace markdown {
+namespace {
+enum class Block { None, Paragraph, UnorderedList, OrderedList, Quote, Code };
+
+// One emphasis delimiter: a single '*' (em) or a "**" pair (strong) taken
+// from a run of asterisks.
+struct Delimiter {
+  size_t pos;
+  char kind; // '*' for em, 'S' for strong
+  bool canOpen;
+  bool canClose;
+  bool matched = false;
+  bool opener = false;
+};
+
+void appendEscaped(std::string &out, char c) {
+  switch (c) {
+  case '&':
+    out += "&amp;";
+    break;
+  case '<':
+    out += "&lt;";
+    break;
+  case '>':
+    out += "&gt;";
+    break;
+  case '"':
+    out += "&quot;";
+    break;
+  case '\'':
+    out += "&#39;";
+    break;
+  default:
+    out += c;
+  }
+}
+
+size_t lengthOf(char kind) { return kind == 'S' ? 2 : 1; }
+
+bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; }
+
+// Splits the asterisk run text[pos, pos + length) into delimiters. Openers
+// put strong outside em ("***a" -> <strong><em>), closers the reverse.
+void splitRun(std::vector<Delimiter> &delimiters, size_t pos, size_t length,
+              bool canOpen, bool canClose) {
+  bool oddFirst = canClose && !canOpen;
+  if (oddFirst && length % 2 == 1) {
+    delimiters.push_back({pos, '*', canOpen, canClose});
+    ++pos;
+    --length;
+  }
+  for (; length >= 2; pos += 2, length -= 2) {
+    delimiters.push_back({pos, 'S', canOpen, canClose});
+  }
+  if (length == 1) {
+    delimiters.push_back({pos, '*', canOpen, canClose});
+  }
+}
+
+// Pairs closers with openers. Each kind has its own stack; when a pair is
+// made, openers of the other kind inside it can no longer close without
+// crossing it, so they are dropped. Every delimiter is pushed and popped at
+// most once, so this is linear.
+void matchDelimiters(std::vector<Delimiter> &delimiters) {
+  std::vector<size_t> em, strong;
+  for (size_t i = 0; i < delimiters.size(); ++i) {
+    Delimiter &d = delimiters[i];
+    std::vector<size_t> &same = d.kind == 'S' ? strong : em;
+    std::vector<size_t> &other = d.kind == 'S' ? em : strong;
+    if (d.canClose && !same.empty()) {
+      Delimiter &opener = delimiters[same.back()];
+      same.pop_back();
+      while (!other.empty() && delimiters[other.back()].pos > opener.pos) {
+        other.pop_back();
+      }
+      opener.matched = true;
+      opener.opener = true;
+      d.matched = true;
+    } else if (d.canOpen) {
+      same.push_back(i);
+    }
+  }
+}
+
+// Renders inline markup for text[begin, end) into out. Backticks pair up
+// left to right into code spans (a leftover one is literal); asterisks
+// outside code become emphasis when they match, following the CommonMark
+// flanking rule: an opener must not be followed by whitespace and a closer
+// must not be preceded by it. Delimiters are matched first so the output is
+// written once.
+void renderInline(std::string &out, const std::string &text, size_t begin,
+                  size_t end) {
+  std::vector<size_t> ticks;
+  for (size_t i = begin; i < end; ++i) {
+    if (text[i] == '`') {
+      ticks.push_back(i);
+    }
+  }
+  size_t pairedTicks = ticks.size() - ticks.size() % 2;
+
+  std::vector<Delimiter> delimiters;
+  size_t tick = 0;
+  for (size_t i = begin; i < end;) {
+    if (tick < pairedTicks && i == ticks[tick]) {
+      i = ticks[tick + 1] + 1;
+      tick += 2;
+      continue;
+    }
+    if (text[i] != '*') {
+      ++i;
+      continue;
+    }
+    size_t runEnd = i;
+    while (runEnd < end && text[runEnd] == '*') {
+      ++runEnd;
+    }
+    bool canOpen = runEnd < end && !isSpace(text[runEnd]);
+    bool canClose = i > begin && !isSpace(text[i - 1]);
+    splitRun(delimiters, i, runEnd - i, canOpen, canClose);
+    i = runEnd;
+  }
+  matchDelimiters(delimiters);
+
+  size_t next = 0;
+  tick = 0;
+  for (size_t i = begin; i < end;) {
+    if (tick < pairedTicks && i == ticks[tick]) {
+      out += "<code>";
+      for (size_t j = i + 1; j < ticks[tick + 1]; ++j) {
+        appendEscaped(out, text[j]);
+      }
+      out += "</code>";
+      i = ticks[tick + 1] + 1;
+      tick += 2;
+      continue;
+    }
+    if (next < delimiters.size() && delimiters[next].pos == i) {
+      const Delimiter &d = delimiters[next++];
+      if (!d.matched) {
+        out += d.kind == 'S' ? "**" : "*";
+      } else if (d.kind == 'S') {
+        out += d.opener ? "<strong>" : "</strong>";
+      } else {
+        out += d.opener ? "<em>" : "</em>";
+      }
+      i += lengthOf(d.kind);
+      continue;
+    }
+    appendEscaped(out, text[i]);
+    ++i;
+  }
+}
+
+void closeBlock(std::string &out, Block &block) {
+  switch (block) {
+  case Block::Paragraph:
+    out += "</p>\n";
+    break;
+  case Block::UnorderedList:
+    out += "</ul>\n";
+    break;
+  case Block::OrderedList:
+    out += "</ol>\n";
+    break;
+  case Block::Quote:
+    out += "</p></blockquote>\n";
+    break;
+  case Block::Code:
+    out += "</code></pre>\n";
+    break;
+  case Block::None:
+    break;
+  }
+  block = Block::None;
+}
+
+void openBlock(std::string &out, Block &block, Block next) {
+  if (block == next) {
+    return;
+  }
+  closeBlock(out, block);
+  switch (next) {
+  case Block::Paragraph:
+    out += "<p>";
+    break;
+  case Block::UnorderedList:
+    out += "<ul>\n";
+    break;
+  case Block::OrderedList:
+    out += "<ol>\n";
+    break;
+  case Block::Quote:
+    out += "<blockquote><p>";
+    break;
+  case Block::Code:
+    out += "<pre><code>";
+    break;
+  case Block::None:
+    break;
+  }
+  block = next;
+}
+} // namespace
+
+std::string escapeHtml(const std::string &text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    appendEscaped(out, c);
+  }
+  return out;
+}
+
+std::string toHtml(const std::string &source) {
+  std::string out;
+  out.reserve(source.size() + source.size() / 4);
+  Block block = Block::None;
+  // Blank lines between list items keep the list open (a "loose" list); it is
+  // only closed once a line that is not one of its items turns up.
+  bool afterBlank = false;
+
+  size_t lineStart = 0;
+  while (lineStart <= source.size()) {
+    size_t lineEnd = source.find('\n', lineStart);
+    if (lineEnd == std::string::npos) {
+      lineEnd = source.size();
+    }
+    size_t begin = lineStart;
+    lineStart = lineEnd + 1;
+
+    size_t i = begin;
+    while (i < lineEnd && (source[i] == ' ' || source[i] == '\t')) {
+      ++i;
+    }
+    size_t end = lineEnd;
+    while (end > i && (source[end - 1] == ' ' || source[end - 1] == '\r')) {
+      --end;
+    }
+
+    bool fence = end - i >= 3 && source.compare(i, 3, "```") == 0;
+    if (block == Block::Code) {
+      if (fence) {
+        closeBlock(out, block);
+      } else {
+        for (size_t j = begin; j < end; ++j) {
+          appendEscaped(out, source[j]);
+        }
+        out += '\n';
+      }
+      continue;
+    }
+
+    if (i == end) {
+      if (block == Block::UnorderedList || block == Block::OrderedList) {
+        afterBlank = true;
+      } else {
+        closeBlock(out, block);
+      }
+      continue;
+    }
+
+    if (fence) {
+      // The info string (language) is dropped; it is not rendered anyway
+      closeBlock(out, block);
+      openBlock(out, block, Block::Code);
+      afterBlank = false;
+      continue;
+    }
+
+    char c = source[i];
+    bool wasAfterBlank = afterBlank;
+    afterBlank = false;
+
+    if ((c == '-' || c == '*' || c == '+') && i + 1 < end &&
+        source[i + 1] == ' ') {
+      openBlock(out, block, Block::UnorderedList);
+      out += "<li>";
+      renderInline(out, source, i + 2, end);
+      out += "</li>\n";
+      continue;
+    }
+
+    size_t digits = i;
+    while (digits < end &&
+           std::isdigit(static_cast<unsigned char>(source[digits]))) {
+      ++digits;
+    }
+    if (digits > i && digits + 1 < end && source[digits] == '.' &&
+        source[digits + 1] == ' ') {
+      if (block != Block::OrderedList && source.compare(i, digits - i, "1") != 0) {
+        closeBlock(out, block);
+        out += "<ol start=\"";
+        out.append(source, i, digits - i);
+        out += "\">\n";
+        block = Block::OrderedList;
+      }
+      openBlock(out, block, Block::OrderedList);
+      out += "<li>";
+      renderInline(out, source, digits + 2, end);
+      out += "</li>\n";
+      continue;
+    }
+
+    size_t level = 0;
+    while (i + level < end && source[i + level] == '#' && level < 6) {
+      ++level;
+    }
+    if (level > 0 && i + level < end && source[i + level] == ' ') {
+      closeBlock(out, block);
+      char tag = static_cast<char>('0' + level);
+      out += "<h";
+      out += tag;
+      out += '>';
+      renderInline(out, source, i + level + 1, end);
+      out += "</h";
+      out += tag;
+      out += ">\n";
+      continue;
+    }
+
+    if (wasAfterBlank) {
+      closeBlock(out, block);
+    }
+
+    if (c == '>') {
+      size_t textStart = (i + 1 < end && source[i + 1] == ' ') ? i + 2 : i + 1;
+      if (block == Block::Quote) {
+        out += '\n';
+      }
+      openBlock(out, block, Block::Quote);
+      renderInline(out, source, textStart, end);
+      continue;
+    }
+
+    if (block == Block::Paragraph) {
+      out += '\n';
+    }
+    openBlock(out, block, Block::Paragraph);
+    renderInline(out, source, i, end);
+  }
+
+  closeBlock(out, block);
+  return out;
+}
+} // namespace markdown
@@ -1,7 +1,15 @@
 #include "server.h"
+#include "trace.h"
+#include <openssl/crypto.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 #include <unistd.h>
+#include <cerrno>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -10,8 +18,10 @@
 #include <cstdlib>
 #include <cstring>
 #include <cctype>
+#include <zlib.h>
 
-SimpleHTTPServer::SimpleHTTPServer(int port) : port_(port), server_fd_(-1), running_(false) {}
+SimpleHTTPServer::SimpleHTTPServer(int port, const ListenerOptions& options)
+    : port_(port), options_(options), server_fd_(-1), running_(false) {}
 
 SimpleHTTPServer::~SimpleHTTPServer() {
     stop();
@@ -19,30 +29,44 @@ SimpleHTTPServer::~SimpleHTTPServer() {
 
 void SimpleHTTPServer::addRoute(const std::string& path, std::function<std::string()> handler) {
     routes_[path] = handler;
+    // A new handler may return a different body, so drop what was built from
+    // the old one
+    invalidateRoute(path);
 }
 
 void SimpleHTTPServer::addRouteWithParam(const std::string& path, std::function<std::string(const std::string&)> handler) {
     param_routes_[path] = handler;
 }
 
-std::string SimpleHTTPServer::parsePath(const std::string& request) {
+void SimpleHTTPServer::addCompositeRoute(const std::string& path, const std::vector<std::pair<std::string, std::string>>& sources) {
+    CompositeRoute route;
+    route.sources = sources;
+    composite_routes_[path] = route;
+}
+
+std::string SimpleHTTPServer::parseTarget(const std::string& request) {
     std::istringstream iss(request);
     std::string line;
     if (std::getline(iss, line)) {
         std::istringstream lineStream(line);
-        std::string method, path, protocol;
-        if (lineStream >> method >> path >> protocol) {
-            // Remove query parameters
-            size_t queryPos = path.find('?');
-            if (queryPos != std::string::npos) {
-                path = path.substr(0, queryPos);
-            }
-            return path;
+        std::string method, target, protocol;
+        if (lineStream >> method >> target >> protocol) {
+            return target;
         }
     }
     return "";
 }
 
+std::string SimpleHTTPServer::parsePath(const std::string& request) {
+    std::string path = parseTarget(request);
+    // Remove query parameters
+    size_t queryPos = path.find('?');
+    if (queryPos != std::string::npos) {
+        path = path.substr(0, queryPos);
+    }
+    return path;
+}
+
 std::string SimpleHTTPServer::getMethod(const std::string& request) {
     std::istringstream iss(request);
     std::string line;
@@ -56,6 +80,61 @@ std::string SimpleHTTPServer::getMethod(const std::string& request) {
     return "";
 }
 
+std::string SimpleHTTPServer::getHeader(const std::string& request, const std::string& name) {
+    std::istringstream iss(request);
+    std::string line;
+    std::getline(iss, line); // Skip request line
+    while (std::getline(iss, line) && line != "\r" && !line.empty()) {
+        size_t colon = line.find(':');
+        if (colon != name.length()) {
+            continue;
+        }
+        bool matches = true;
+        for (size_t i = 0; i < colon; ++i) {
+            if (std::tolower(static_cast<unsigned char>(line[i])) != std::tolower(static_cast<unsigned char>(name[i]))) {
+                matches = false;
+                break;
+            }
+        }
+        if (!matches) {
+            continue;
+        }
+        size_t start = line.find_first_not_of(" \t", colon + 1);
+        size_t end = line.find_last_not_of(" \t\r");
+        if (start == std::string::npos || end < start) {
+            return "";
+        }
+        return line.substr(start, end - start + 1);
+    }
+    return "";
+}
+
+std::string SimpleHTTPServer::getQueryParam(const std::string& target, const std::string& name) {
+    size_t queryPos = target.find('?');
+    if (queryPos == std::string::npos) {
+        return "";
+    }
+    size_t start = queryPos + 1;
+    while (start < target.length()) {
+        size_t end = target.find('&', start);
+        if (end == std::string::npos) {
+            end = target.length();
+        }
+        size_t eq = target.find('=', start);
+        if (eq < end && target.compare(start, eq - start, name) == 0 && eq - start == name.length()) {
+            std::string value = target.substr(eq + 1, end - eq - 1);
+            // Commas are the only reserved character a field list needs
+            size_t escaped;
+            while ((escaped = value.find("%2C")) != std::string::npos || (escaped = value.find("%2c")) != std::string::npos) {
+                value.replace(escaped, 3, ",");
+            }
+            return value;
+        }
+        start = end + 1;
+    }
+    return "";
+}
+
 bool SimpleHTTPServer::validatePath(const std::string& path) {
     // Basic path validation - prevent path traversal
     if (path.find("..") != std::string::npos) {
@@ -93,12 +172,20 @@ std::string SimpleHTTPServer::getAllowedOrigin() {
     return "http://localhost:3000";
 }
 
-std::string SimpleHTTPServer::createResponse(const std::string& body, const std::string& contentType, int statusCode) {
+std::string SimpleHTTPServer::createResponse(const std::string& body, const std::string& contentType, int statusCode, const std::string& extraHeaders) {
     std::ostringstream response;
     if (statusCode == 200) {
         response << "HTTP/1.1 200 OK\r\n";
+    } else if (statusCode == 304) {
+        response << "HTTP/1.1 304 Not Modified\r\n";
+    } else if (statusCode == 400) {
+        response << "HTTP/1.1 400 Bad Request\r\n";
+    } else if (statusCode == 401) {
+        response << "HTTP/1.1 401 Unauthorized\r\n";
     } else if (statusCode == 404) {
         response << "HTTP/1.1 404 Not Found\r\n";
+    } else if (statusCode == 405) {
+        response << "HTTP/1.1 405 Method Not Allowed\r\n";
     } else {
         response << "HTTP/1.1 500 Internal Server Error\r\n";
     }
@@ -110,12 +197,140 @@ std::string SimpleHTTPServer::createResponse(const std::string& body, const std:
     response << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
     response << "Access-Control-Allow-Headers: Content-Type\r\n";
     response << "Access-Control-Allow-Credentials: true\r\n";
+    response << extraHeaders;
     response << "Content-Length: " << body.length() << "\r\n";
     response << "\r\n";
     response << body;
     return response.str();
 }
 
+// Compresses data into a gzip member. Returns an empty string on failure.
+static std::string gzipCompress(const std::string& data) {
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return "";
+    }
+    std::string compressed(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+    stream.avail_out = compressed.size();
+    int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return "";
+    }
+    compressed.resize(stream.total_out);
+    return compressed;
+}
+
+ProjectionCache& SimpleHTTPServer::routeFragments(const std::string& path) {
+    // Only registered exact routes get here, so the map stays bounded
+    ProjectionCache& cache = projection_cache_[path];
+    if (!cache.loaded) {
+        trace::Span span("handler", path);
+        cache.projectable = cache.fieldSet.load(routes_[path]());
+        cache.loaded = true;
+    }
+    return cache;
+}
+
+std::string SimpleHTTPServer::projectFields(const std::string& path, const std::vector<std::string>& fields) {
+    ProjectionCache& cache = routeFragments(path);
+    trace::Span span("project", path);
+    if (!cache.projectable) {
+        return cache.fieldSet.source();
+    }
+
+    // Unknown names don't change the result, so they must not create entries
+    std::vector<std::string> known = cache.fieldSet.known(fields);
+    if (known.empty()) {
+        return cache.fieldSet.project(known);
+    }
+
+    std::string key;
+    for (const auto& field : known) {
+        key += key.empty() ? field : "," + field;
+    }
+    auto it = cache.projections.find(key);
+    if (it != cache.projections.end()) {
+        return it->second;
+    }
+    std::string projected = cache.fieldSet.project(known);
+    if (cache.projections.size() < ProjectionCache::kMaxProjections) {
+        cache.projections.emplace(key, projected);
+    }
+    return projected;
+}
+
+void SimpleHTTPServer::invalidateRoute(const std::string& path) {
+    projection_cache_.erase(path);
+    for (auto& entry : composite_routes_) {
+        for (const auto& source : entry.second.sources) {
+            if (source.second.substr(0, source.second.find('?')) == path) {
+                entry.second.built = false;
+            }
+        }
+    }
+}
+
+void SimpleHTTPServer::buildComposite(CompositeRoute& route) {
+    std::string body = "{";
+    for (size_t i = 0; i < route.sources.size(); ++i) {
+        const std::string& source = route.sources[i].second;
+        // A source may ask for a sparse fieldset, e.g. "/api/blog?fields=id,title"
+        std::string sourcePath = source.substr(0, source.find('?'));
+        std::vector<std::string> fields;
+        parseFieldList(getQueryParam(source, "fields"), fields);
+
+        std::string sourceBody = "null";
+        if (routes_.find(sourcePath) != routes_.end()) {
+            const ProjectionCache& cache = routeFragments(sourcePath);
+            sourceBody = !fields.empty() && cache.projectable
+                ? cache.fieldSet.project(fields)
+                : cache.fieldSet.source();
+        }
+
+        if (i > 0) {
+            body += ",";
+        }
+        body += "\"" + route.sources[i].first + "\":" + sourceBody;
+    }
+    body += "}";
+
+    std::ostringstream etag;
+    etag << "\"" << std::hex << std::hash<std::string>{}(body) << "\"";
+    route.etag = etag.str();
+
+    std::string headers = "ETag: " + route.etag + "\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "Vary: Accept-Encoding\r\n";
+    route.response = createResponse(body, "application/json", 200, headers);
+    std::string compressed = gzipCompress(body);
+    route.gzipResponse = compressed.empty()
+        ? route.response
+        : createResponse(compressed, "application/json", 200, headers + "Content-Encoding: gzip\r\n");
+    route.built = true;
+}
+
+std::string SimpleHTTPServer::serveComposite(CompositeRoute& route, const std::string& request) {
+    trace::Span span("composite");
+    // Built on first use; sources are not called again until one of them is
+    // registered again
+    if (!route.built) {
+        buildComposite(route);
+    }
+
+    std::string ifNoneMatch = getHeader(request, "If-None-Match");
+    if (!ifNoneMatch.empty() && (ifNoneMatch == "*" || ifNoneMatch.find(route.etag) != std::string::npos)) {
+        return createResponse("", "application/json", 304, "ETag: " + route.etag + "\r\nVary: Accept-Encoding\r\n");
+    }
+    if (getHeader(request, "Accept-Encoding").find("gzip") != std::string::npos) {
+        return route.gzipResponse;
+    }
+    return route.response;
+}
+
 std::string SimpleHTTPServer::readFile(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -126,28 +341,91 @@ std::string SimpleHTTPServer::readFile(const std::string& path) {
     return buffer.str();
 }
 
-void SimpleHTTPServer::handleRequest(int client_fd) {
+// SIGUSR1 (trace dumps) is installed without SA_RESTART so that it wakes
+// accept(). Socket calls it interrupts mid-request are retried here.
+static ssize_t readRequest(int client_fd, SSL* ssl, char* buffer, size_t size) {
+    while (true) {
+        errno = 0;
+        ssize_t result = ssl ? SSL_read(ssl, buffer, static_cast<int>(size)) : read(client_fd, buffer, size);
+        bool retry = ssl ? TlsContext::interrupted(ssl, static_cast<int>(result)) : result < 0 && errno == EINTR;
+        if (!retry) {
+            return result;
+        }
+    }
+}
+
+static void writeResponse(int client_fd, SSL* ssl, const std::string& response) {
+    size_t sent = 0;
+    while (sent < response.length()) {
+        errno = 0;
+        ssize_t result;
+        if (!ssl || TlsContext::kernelSend(ssl)) {
+            result = send(client_fd, response.c_str() + sent, response.length() - sent, MSG_NOSIGNAL);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+        } else {
+            result = SSL_write(ssl, response.c_str() + sent, static_cast<int>(response.length() - sent));
+            if (TlsContext::interrupted(ssl, static_cast<int>(result))) {
+                continue;
+            }
+        }
+        if (result <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(result);
+    }
+}
+
+void SimpleHTTPServer::handleRequest(int client_fd, SSL* ssl) {
+    trace::Span request_span("request");
+    
     char buffer[4096] = {0};
-    ssize_t bytes_read = read(client_fd, buffer, 4095);
+    ssize_t bytes_read;
+    {
+        trace::Span span("read");
+        bytes_read = readRequest(client_fd, ssl, buffer, 4095);
+    }
     
     if (bytes_read <= 0) {
-        close(client_fd);
+        closeConnection(client_fd, ssl);
         return;
     }
     
     std::string request(buffer, bytes_read);
-    std::string method = getMethod(request);
-    std::string path = parsePath(request);
+    std::string method, path, target;
+    {
+        trace::Span span("parse");
+        method = getMethod(request);
+        path = parsePath(request);
+        target = parseTarget(request);
+    }
+    request_span.setDetail(method + " " + path);
     
     // Log request (basic middleware)
     std::cout << "[" << method << "] " << path << std::endl;
     
+    bool path_valid, fields_valid;
+    std::vector<std::string> fields;
+    {
+        trace::Span span("validate");
+        path_valid = validatePath(path);
+        // Sparse fieldset, e.g. ?fields=name,url
+        fields_valid = path_valid && parseFieldList(getQueryParam(target, "fields"), fields);
+    }
+    
     // Validate path
-    if (!validatePath(path)) {
+    if (!path_valid) {
         std::string response_body = "{\"error\": \"Invalid path\"}";
         std::string response = createResponse(response_body, "application/json", 400);
-        send(client_fd, response.c_str(), response.length(), 0);
-        close(client_fd);
+        sendResponse(client_fd, ssl, response);
+        return;
+    }
+    
+    if (!fields_valid) {
+        std::string response_body = "{\"error\": \"Invalid fields\"}";
+        std::string response = createResponse(response_body, "application/json", 400);
+        sendResponse(client_fd, ssl, response);
         return;
     }
     
@@ -160,8 +438,13 @@ void SimpleHTTPServer::handleRequest(int client_fd) {
                               "Access-Control-Allow-Headers: Content-Type\r\n"
                               "Access-Control-Allow-Credentials: true\r\n"
                               "\r\n";
-        send(client_fd, response.c_str(), response.length(), 0);
-        close(client_fd);
+        sendResponse(client_fd, ssl, response);
+        return;
+    }
+    
+    if (path == "/admin/trace") {
+        std::string response = handleTraceAdmin(method, request, target);
+        sendResponse(client_fd, ssl, response);
         return;
     }
     
@@ -169,17 +452,31 @@ void SimpleHTTPServer::handleRequest(int client_fd) {
     if (method != "GET" && method != "OPTIONS") {
         std::string response_body = "{\"error\": \"Method not allowed\"}";
         std::string response = createResponse(response_body, "application/json", 405);
-        send(client_fd, response.c_str(), response.length(), 0);
-        close(client_fd);
+        sendResponse(client_fd, ssl, response);
         return;
     }
     
     std::string response_body;
     std::string content_type = "application/json";
+    trace::Span dispatch_span("dispatch");
+    
+    // Composite routes carry their own headers, so they are sent as-is
+    if (composite_routes_.find(path) != composite_routes_.end()) {
+        std::string response = serveComposite(composite_routes_[path], request);
+        dispatch_span.end();
+        sendResponse(client_fd, ssl, response);
+        return;
+    }
     
     // Check exact routes first
     if (routes_.find(path) != routes_.end()) {
-        response_body = routes_[path]();
+        if (!fields.empty()) {
+            // Projected from fragments built once per route
+            response_body = projectFields(path, fields);
+        } else {
+            trace::Span span("handler", path);
+            response_body = routes_[path]();
+        }
     }
     // Check parameterized routes
     else if (path.find("/api/blog/") == 0) {
@@ -189,25 +486,28 @@ void SimpleHTTPServer::handleRequest(int client_fd) {
         if (!validateId(id)) {
             response_body = "{\"error\": \"Invalid blog post ID\"}";
             std::string response = createResponse(response_body, content_type, 400);
-            send(client_fd, response.c_str(), response.length(), 0);
-            close(client_fd);
+            dispatch_span.end();
+            sendResponse(client_fd, ssl, response);
             return;
         }
         
         if (param_routes_.find("/api/blog/:id") != param_routes_.end()) {
-            response_body = param_routes_["/api/blog/:id"](id);
+            {
+                trace::Span span("handler", path);
+                response_body = param_routes_["/api/blog/:id"](id);
+            }
             if (response_body == "{}") {
                 response_body = "{\"error\": \"Post not found\"}";
                 std::string response = createResponse(response_body, content_type, 404);
-                send(client_fd, response.c_str(), response.length(), 0);
-                close(client_fd);
+                dispatch_span.end();
+                sendResponse(client_fd, ssl, response);
                 return;
             }
         } else {
             response_body = "{\"error\": \"Not found\"}";
             std::string response = createResponse(response_body, content_type, 404);
-            send(client_fd, response.c_str(), response.length(), 0);
-            close(client_fd);
+            dispatch_span.end();
+            sendResponse(client_fd, ssl, response);
             return;
         }
     }
@@ -222,12 +522,13 @@ void SimpleHTTPServer::handleRequest(int client_fd) {
             if (!validateId(id)) {
                 response_body = "{\"error\": \"Invalid game ID\"}";
                 std::string response = createResponse(response_body, content_type, 400);
-                send(client_fd, response.c_str(), response.length(), 0);
-                close(client_fd);
+                dispatch_span.end();
+                sendResponse(client_fd, ssl, response);
                 return;
             }
             
             if (param_routes_.find("/api/games/:id/leaderboard") != param_routes_.end()) {
+                trace::Span span("handler", path);
                 response_body = param_routes_["/api/games/:id/leaderboard"](id);
             } else {
                 response_body = "[]";
@@ -239,61 +540,265 @@ void SimpleHTTPServer::handleRequest(int client_fd) {
     else {
         response_body = "{\"error\": \"Not found\"}";
         std::string response = createResponse(response_body, content_type, 404);
-        send(client_fd, response.c_str(), response.length(), 0);
-        close(client_fd);
+        dispatch_span.end();
+        sendResponse(client_fd, ssl, response);
         return;
     }
     
+    if (!fields.empty() && routes_.find(path) == routes_.end()) {
+        // Parameterized bodies differ per id and are projected per request
+        trace::Span span("project", path);
+        FieldSet fieldSet;
+        if (fieldSet.load(response_body)) {
+            response_body = fieldSet.project(fields);
+        }
+    }
+    
     std::string response = createResponse(response_body, content_type);
-    send(client_fd, response.c_str(), response.length(), 0);
+    dispatch_span.end();
+    sendResponse(client_fd, ssl, response);
+}
+
+void SimpleHTTPServer::sendResponse(int client_fd, SSL* ssl, const std::string& response) {
+    {
+        trace::Span span("send");
+        // With kernel TLS the socket takes plaintext and the kernel encrypts
+        // while copying it in, skipping OpenSSL's separate encryption buffer
+        writeResponse(client_fd, ssl, response);
+    }
+    closeConnection(client_fd, ssl);
+}
+
+void SimpleHTTPServer::closeConnection(int client_fd, SSL* ssl) {
+    if (ssl) {
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+    }
     close(client_fd);
 }
 
-void SimpleHTTPServer::start() {
-    server_fd_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd_ < 0) {
+// GET /admin/trace dumps buffered spans as Chrome trace_event JSON.
+// POST /admin/trace?enabled=0|1&sample=N changes the settings and returns
+// them. Requires "Authorization: Bearer $ADMIN_TOKEN"; disabled when
+// ADMIN_TOKEN is unset.
+std::string SimpleHTTPServer::handleTraceAdmin(const std::string& method, const std::string& request, const std::string& target) {
+    const char* token = std::getenv("ADMIN_TOKEN");
+    if (!token || strlen(token) == 0) {
+        return createResponse("{\"error\": \"Not found\"}", "application/json", 404);
+    }
+    // Constant-time comparison so response timing doesn't leak the token
+    std::string expected = "Bearer " + std::string(token);
+    std::string authorization = getHeader(request, "Authorization");
+    if (authorization.length() != expected.length() ||
+        CRYPTO_memcmp(authorization.data(), expected.data(), expected.length()) != 0) {
+        return createResponse("{\"error\": \"Unauthorized\"}", "application/json", 401);
+    }
+
+    if (method == "GET") {
+        return createResponse(trace::dumpJson());
+    }
+    if (method != "POST") {
+        return createResponse("{\"error\": \"Method not allowed\"}", "application/json", 405);
+    }
+
+    std::string enabled = getQueryParam(target, "enabled");
+    std::string sample = getQueryParam(target, "sample");
+    if (!enabled.empty()) {
+        trace::setEnabled(enabled == "1" || enabled == "true");
+    }
+    if (!sample.empty()) {
+        trace::setSampleRate(static_cast<unsigned>(std::strtoul(sample.c_str(), nullptr, 10)));
+    }
+    std::ostringstream status;
+    status << "{\"enabled\": " << (trace::isEnabled() ? "true" : "false")
+           << ", \"sample\": " << trace::sampleRate() << "}";
+    return createResponse(status.str());
+}
+
+// Unlinks `path` if it is a socket. Returns false if something other than a
+// socket is there; a missing path is fine.
+static bool removeStaleSocket(const std::string& path) {
+    struct stat info;
+    if (lstat(path.c_str(), &info) < 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        return false;
+    }
+    unlink(path.c_str());
+    return true;
+}
+
+// Creates, binds and starts listening on the configured socket. Returns the
+// listening descriptor, or -1 after logging the failing step.
+int SimpleHTTPServer::createListener() {
+    if (!options_.unixSocketPath.empty()) {
+        struct sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (options_.unixSocketPath.length() >= sizeof(address.sun_path)) {
+            std::cerr << "Unix socket path too long" << std::endl;
+            return -1;
+        }
+        std::strncpy(address.sun_path, options_.unixSocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            std::cerr << "Error creating socket" << std::endl;
+            return -1;
+        }
+        // Remove a socket file left behind by a previous run, but never
+        // anything else that happens to live at the path
+        if (!removeStaleSocket(options_.unixSocketPath)) {
+            std::cerr << "Refusing to replace " << options_.unixSocketPath << ": not a socket" << std::endl;
+            close(fd);
+            return -1;
+        }
+        if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+            std::cerr << "Error binding socket" << std::endl;
+            close(fd);
+            return -1;
+        }
+        // The proxy usually runs as a different user in a shared group
+        if (chmod(options_.unixSocketPath.c_str(), options_.unixSocketMode) < 0) {
+            std::cerr << "Error setting mode on " << options_.unixSocketPath << ": " << std::strerror(errno) << std::endl;
+        }
+        if (listen(fd, options_.backlog) < 0) {
+            std::cerr << "Error listening" << std::endl;
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    struct sockaddr_storage address;
+    socklen_t address_len;
+    std::memset(&address, 0, sizeof(address));
+    bool use_ipv6 = options_.bindAddress.empty() ? options_.ipv6 : options_.bindAddress.find(':') != std::string::npos;
+    if (use_ipv6) {
+        struct sockaddr_in6* in6 = (struct sockaddr_in6 *)&address;
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port_);
+        in6->sin6_addr = in6addr_any;
+        if (!options_.bindAddress.empty() && inet_pton(AF_INET6, options_.bindAddress.c_str(), &in6->sin6_addr) != 1) {
+            std::cerr << "Invalid bind address: " << options_.bindAddress << std::endl;
+            return -1;
+        }
+        address_len = sizeof(struct sockaddr_in6);
+    } else {
+        struct sockaddr_in* in4 = (struct sockaddr_in *)&address;
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(port_);
+        in4->sin_addr.s_addr = INADDR_ANY;
+        if (!options_.bindAddress.empty() && inet_pton(AF_INET, options_.bindAddress.c_str(), &in4->sin_addr) != 1) {
+            std::cerr << "Invalid bind address: " << options_.bindAddress << std::endl;
+            return -1;
+        }
+        address_len = sizeof(struct sockaddr_in);
+    }
+
+    int fd = socket(address.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
         std::cerr << "Error creating socket" << std::endl;
-        return;
+        return -1;
     }
-    
+
     int opt = 1;
-    setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    
-    struct sockaddr_in address;
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port_);
-    
-    if (bind(server_fd_, (struct sockaddr *)&address, sizeof(address)) < 0) {
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (use_ipv6) {
+        int v6only = options_.ipv6Only ? 1 : 0;
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+    }
+    // Accepted sockets inherit these from the listener
+    if (options_.tcpNoDelay) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    }
+#ifdef TCP_DEFER_ACCEPT
+    if (options_.deferAcceptSeconds > 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &options_.deferAcceptSeconds, sizeof(options_.deferAcceptSeconds));
+    }
+#endif
+#ifdef TCP_FASTOPEN
+    if (options_.fastOpenQueue > 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN, &options_.fastOpenQueue, sizeof(options_.fastOpenQueue));
+    }
+#endif
+
+    if (bind(fd, (struct sockaddr *)&address, address_len) < 0) {
         std::cerr << "Error binding socket" << std::endl;
-        close(server_fd_);
-        return;
+        close(fd);
+        return -1;
     }
-    
-    if (listen(server_fd_, 10) < 0) {
+
+    if (listen(fd, options_.backlog) < 0) {
         std::cerr << "Error listening" << std::endl;
-        close(server_fd_);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void SimpleHTTPServer::start() {
+    if (!options_.tlsCertFile.empty() && !options_.tlsKeyFile.empty()) {
+        tls_ = TlsContext::create(options_.tlsCertFile, options_.tlsKeyFile,
+                                  options_.kernelTls, options_.tlsTicketRotationSeconds);
+        if (!tls_) {
+            return;
+        }
+    }
+    
+    server_fd_ = createListener();
+    if (server_fd_ < 0) {
         return;
     }
     
     running_ = true;
-    std::cout << "Server started on port " << port_ << std::endl;
+    const char* scheme = tls_ ? " (TLS)" : "";
+    if (!options_.unixSocketPath.empty()) {
+        std::cout << "Server started on unix:" << options_.unixSocketPath << scheme << std::endl;
+    } else {
+        std::cout << "Server started on port " << port_ << scheme << std::endl;
+    }
     
     while (running_) {
-        struct sockaddr_in client_address;
+        struct sockaddr_storage client_address;
         socklen_t client_len = sizeof(client_address);
         int client_fd = accept(server_fd_, (struct sockaddr *)&client_address, &client_len);
         
         if (client_fd < 0) {
-            if (running_) {
+            // A trace dump signal interrupts accept()
+            trace::dumpIfRequested();
+            if (running_ && errno != EINTR) {
                 std::cerr << "Error accepting connection" << std::endl;
             }
             continue;
         }
         
+        // The server handles one connection at a time, so a client that
+        // stalls during the handshake or request must not hold it forever
+        if (options_.clientTimeoutSeconds > 0) {
+            struct timeval timeout;
+            timeout.tv_sec = options_.clientTimeoutSeconds;
+            timeout.tv_usec = 0;
+            setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        }
+        
+        trace::sampleRequest();
+        SSL* ssl = nullptr;
+        if (tls_) {
+            trace::Span span("handshake");
+            ssl = tls_->accept(client_fd);
+            if (!ssl) {
+                close(client_fd);
+                continue;
+            }
+        }
+        
         // Handle each request in the current thread (simple approach)
         // For production, use thread pool
-        handleRequest(client_fd);
+        handleRequest(client_fd, ssl);
+        trace::dumpIfRequested();
     }
 }
 
@@ -302,6 +807,9 @@ void SimpleHTTPServer::stop() {
     if (server_fd_ >= 0) {
         close(server_fd_);
         server_fd_ = -1;
+        if (!options_.unixSocketPath.empty()) {
+            removeStaleSocket(options_.unixSocketPath);
+        }
     }
 }
 
@@ -3,30 +3,98 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <utility>
+#include <vector>
+#include <memory>
+#include "fieldset.h"
+#include "tls.h"
+
+// A route whose body is a JSON object assembled from other routes. The
+// document and its gzip encoding are built on first request and reused until
+// one of its sources is registered again with addRoute().
+struct CompositeRoute {
+    std::vector<std::pair<std::string, std::string>> sources; // JSON key -> route path
+    bool built = false;
+    std::string etag;
+    std::string response;      // identity-encoded, headers included
+    std::string gzipResponse;  // gzip-encoded, headers included
+};
+
+// How the server listens. Defaults match a plain IPv4 TCP listener on all
+// interfaces.
+struct ListenerOptions {
+    std::string unixSocketPath;  // Listen on this AF_UNIX path instead of TCP
+    unsigned unixSocketMode = 0660; // Permissions of the socket file
+    std::string bindAddress;     // IPv4 or IPv6 literal; empty binds all interfaces
+    bool ipv6 = false;           // Use an AF_INET6 socket when bindAddress is empty
+    bool ipv6Only = false;       // Disable dual-stack on AF_INET6 sockets
+    int backlog = 128;
+    bool tcpNoDelay = false;
+    int deferAcceptSeconds = 0;  // TCP_DEFER_ACCEPT, 0 to disable (Linux only)
+    int fastOpenQueue = 0;       // TCP_FASTOPEN queue length, 0 to disable
+    int clientTimeoutSeconds = 10; // Read/write timeout per connection, 0 to disable
+
+    // TLS is enabled when both files are set
+    std::string tlsCertFile;     // PEM certificate chain
+    std::string tlsKeyFile;      // PEM private key
+    bool kernelTls = true;       // Hand record encryption to the kernel (kTLS)
+    int tlsTicketRotationSeconds = 3600;
+};
+
+// An exact route's body split into field fragments, plus the projections
+// served from it memoized per normalized list of known fields. Loaded from the
+// handler on first use and, like composite routes, dropped when the route is
+// registered again. Projections are bounded since field lists come from
+// clients.
+struct ProjectionCache {
+    static const size_t kMaxProjections = 32;
+
+    bool loaded = false;
+    bool projectable = false;
+    FieldSet fieldSet; // fieldSet.source() is the handler's body
+    std::map<std::string, std::string> projections; // "a,b,c" -> body
+};
 
 class SimpleHTTPServer {
 public:
-    SimpleHTTPServer(int port);
+    SimpleHTTPServer(int port, const ListenerOptions& options = ListenerOptions());
     ~SimpleHTTPServer();
     
     void addRoute(const std::string& path, std::function<std::string()> handler);
     void addRouteWithParam(const std::string& path, std::function<std::string(const std::string&)> handler);
+    void addCompositeRoute(const std::string& path, const std::vector<std::pair<std::string, std::string>>& sources);
     void start();
     void stop();
     
 private:
     int port_;
+    ListenerOptions options_;
+    std::unique_ptr<TlsContext> tls_;
     int server_fd_;
     bool running_;
     std::map<std::string, std::function<std::string()>> routes_;
     std::map<std::string, std::function<std::string(const std::string&)>> param_routes_;
+    std::map<std::string, CompositeRoute> composite_routes_;
+    std::map<std::string, ProjectionCache> projection_cache_;
     
-    void handleRequest(int client_fd);
+    int createListener();
+    void handleRequest(int client_fd, SSL* ssl);
+    void sendResponse(int client_fd, SSL* ssl, const std::string& response);
+    void closeConnection(int client_fd, SSL* ssl);
+    std::string handleTraceAdmin(const std::string& method, const std::string& request, const std::string& target);
+    std::string parseTarget(const std::string& request);
     std::string parsePath(const std::string& request);
     std::string getMethod(const std::string& request);
+    std::string getHeader(const std::string& request, const std::string& name);
+    std::string getQueryParam(const std::string& target, const std::string& name);
     bool validatePath(const std::string& path);
     bool validateId(const std::string& id);
-    std::string createResponse(const std::string& body, const std::string& contentType = "application/json", int statusCode = 200);
+    std::string createResponse(const std::string& body, const std::string& contentType = "application/json", int statusCode = 200, const std::string& extraHeaders = "");
+    void invalidateRoute(const std::string& path);
+    void buildComposite(CompositeRoute& route);
+    std::string serveComposite(CompositeRoute& route, const std::string& request);
+    ProjectionCache& routeFragments(const std::string& path);
+    std::string projectFields(const std::string& path, const std::vector<std::string>& fields);
     std::string readFile(const std::string& path);
     std::string getAllowedOrigin();
 };
@@ -0,0 +1,187 @@
+#include "tls.h"
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/core_names.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+// Index of the owning TlsContext in SSL_CTX ex_data, for the ticket callback
+int contextIndex() {
+    static int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+void logSslError(const std::string& what) {
+    unsigned long code = ERR_get_error();
+    char message[256] = {0};
+    if (code != 0) {
+        ERR_error_string_n(code, message, sizeof(message));
+    }
+    std::cerr << what << (code != 0 ? ": " : "") << message << std::endl;
+    ERR_clear_error();
+}
+}
+
+std::unique_ptr<TlsContext> TlsContext::create(const std::string& certFile, const std::string& keyFile,
+                                               bool kernelTls, int ticketRotationSeconds) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) {
+        logSslError("Error creating TLS context");
+        return nullptr;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+
+    if (SSL_CTX_use_certificate_chain_file(ctx, certFile.c_str()) != 1) {
+        logSslError("Error loading TLS certificate " + certFile);
+        SSL_CTX_free(ctx);
+        return nullptr;
+    }
+    if (SSL_CTX_use_PrivateKey_file(ctx, keyFile.c_str(), SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(ctx) != 1) {
+        logSslError("Error loading TLS private key " + keyFile);
+        SSL_CTX_free(ctx);
+        return nullptr;
+    }
+
+    // Resumption is ticket-based; the server keeps no per-session state
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_num_tickets(ctx, 1);
+
+#ifdef SSL_OP_ENABLE_KTLS
+    // OpenSSL installs the "tls" TCP ULP and hands the keys to the kernel
+    // after the handshake, falling back to userspace if the kernel lacks it
+    if (kernelTls) {
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+    }
+#else
+    if (kernelTls) {
+        std::cerr << "Kernel TLS not supported by this OpenSSL build" << std::endl;
+    }
+#endif
+
+    std::unique_ptr<TlsContext> context(new TlsContext(ctx, ticketRotationSeconds));
+    if (!context->generateTicketKey(context->currentKey_)) {
+        logSslError("Error generating TLS ticket key");
+        return nullptr;
+    }
+    SSL_CTX_set_ex_data(ctx, contextIndex(), context.get());
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticketKeyCallback);
+    return context;
+}
+
+TlsContext::TlsContext(SSL_CTX* ctx, int ticketRotationSeconds)
+    : ctx_(ctx),
+      ticketRotationSeconds_(ticketRotationSeconds > 0 ? ticketRotationSeconds : 3600),
+      ticketKeyCreated_(time(nullptr)),
+      hasPreviousKey_(false) {
+    std::memset(&currentKey_, 0, sizeof(currentKey_));
+    std::memset(&previousKey_, 0, sizeof(previousKey_));
+}
+
+TlsContext::~TlsContext() {
+    SSL_CTX_free(ctx_);
+    OPENSSL_cleanse(&currentKey_, sizeof(currentKey_));
+    OPENSSL_cleanse(&previousKey_, sizeof(previousKey_));
+}
+
+bool TlsContext::generateTicketKey(TicketKey& key) {
+    return RAND_bytes(key.name, sizeof(key.name)) == 1 &&
+           RAND_bytes(key.hmacKey, sizeof(key.hmacKey)) == 1 &&
+           RAND_bytes(key.aesKey, sizeof(key.aesKey)) == 1;
+}
+
+void TlsContext::rotateTicketKeysIfDue() {
+    time_t now = time(nullptr);
+    if (now - ticketKeyCreated_ < ticketRotationSeconds_) {
+        return;
+    }
+    TicketKey next;
+    if (!generateTicketKey(next)) {
+        logSslError("Error rotating TLS ticket key");
+        return;
+    }
+    previousKey_ = currentKey_;
+    hasPreviousKey_ = true;
+    currentKey_ = next;
+    OPENSSL_cleanse(&next, sizeof(next));
+    ticketKeyCreated_ = now;
+}
+
+// Seals new tickets with the current key and opens tickets sealed with the
+// current or previous one. Returning 2 asks OpenSSL to issue a fresh ticket.
+int TlsContext::ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv,
+                                  EVP_CIPHER_CTX* cipherCtx, EVP_MAC_CTX* macCtx, int encrypt) {
+    TlsContext* context = static_cast<TlsContext*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), contextIndex()));
+    if (!context) {
+        return -1;
+    }
+
+    const TicketKey* key = nullptr;
+    int result = 1;
+    if (encrypt) {
+        key = &context->currentKey_;
+        std::memcpy(name, key->name, sizeof(key->name));
+        if (RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1) {
+            return -1;
+        }
+    } else if (std::memcmp(name, context->currentKey_.name, sizeof(context->currentKey_.name)) == 0) {
+        key = &context->currentKey_;
+    } else if (context->hasPreviousKey_ &&
+               std::memcmp(name, context->previousKey_.name, sizeof(context->previousKey_.name)) == 0) {
+        key = &context->previousKey_;
+        result = 2;
+    } else {
+        // Unknown or expired key: fall back to a full handshake
+        return 0;
+    }
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(key->hmacKey), sizeof(key->hmacKey)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end(),
+    };
+    if (EVP_MAC_CTX_set_params(macCtx, params) != 1) {
+        return -1;
+    }
+    int ok = encrypt
+        ? EVP_EncryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key->aesKey, iv)
+        : EVP_DecryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key->aesKey, iv);
+    return ok == 1 ? result : -1;
+}
+
+SSL* TlsContext::accept(int fd) {
+    rotateTicketKeysIfDue();
+
+    SSL* ssl = SSL_new(ctx_);
+    if (!ssl) {
+        logSslError("Error creating TLS session");
+        return nullptr;
+    }
+    SSL_set_fd(ssl, fd);
+    int result;
+    do {
+        errno = 0;
+        result = SSL_accept(ssl);
+    } while (interrupted(ssl, result));
+    if (result != 1) {
+        logSslError("TLS handshake failed");
+        SSL_free(ssl);
+        return nullptr;
+    }
+    return ssl;
+}
+
+bool TlsContext::interrupted(SSL* ssl, int result) {
+    if (result > 0 || errno != EINTR) {
+        return false;
+    }
+    int error = SSL_get_error(ssl, result);
+    return error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_SYSCALL;
+}
+
+bool TlsContext::kernelSend(SSL* ssl) {
+    return BIO_get_ktls_send(SSL_get_wbio(ssl)) != 0;
+}
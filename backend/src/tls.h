@@ -0,0 +1,54 @@
+#pragma once
+
+#include <openssl/ssl.h>
+#include <ctime>
+#include <memory>
+#include <string>
+
+// Server-side TLS built on OpenSSL. Sessions resume through stateless
+// tickets whose keys rotate periodically; tickets sealed with the previous
+// key are still accepted (and renewed) for one more period. When kernel TLS
+// is available, record encryption moves into the kernel after the handshake.
+class TlsContext {
+public:
+    // Loads the PEM certificate chain and private key. Returns nullptr after
+    // logging the error if they cannot be used.
+    static std::unique_ptr<TlsContext> create(const std::string& certFile, const std::string& keyFile,
+                                              bool kernelTls, int ticketRotationSeconds);
+    ~TlsContext();
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    // Runs the server handshake on a connected socket. Returns nullptr if it
+    // fails; the caller still owns and closes fd.
+    SSL* accept(int fd);
+
+    // True once the kernel encrypts records sent on this connection, so
+    // plaintext can be written to the socket directly.
+    static bool kernelSend(SSL* ssl);
+
+    // True if an SSL_* call returning `result` was cut short by a signal and
+    // should be retried. errno must be cleared before the call.
+    static bool interrupted(SSL* ssl, int result);
+
+private:
+    struct TicketKey {
+        unsigned char name[16];
+        unsigned char hmacKey[32];
+        unsigned char aesKey[32];
+    };
+
+    SSL_CTX* ctx_;
+    int ticketRotationSeconds_;
+    time_t ticketKeyCreated_;
+    TicketKey currentKey_;
+    TicketKey previousKey_;
+    bool hasPreviousKey_;
+
+    explicit TlsContext(SSL_CTX* ctx, int ticketRotationSeconds);
+    bool generateTicketKey(TicketKey& key);
+    void rotateTicketKeysIfDue();
+    static int ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv,
+                                 EVP_CIPHER_CTX* cipherCtx, EVP_MAC_CTX* macCtx, int encrypt);
+};
@@ -0,0 +1,215 @@
+#include "trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace trace {
+namespace {
+constexpr size_t kBufferSize = 4096;
+constexpr size_t kDetailSize = 48;
+
+struct Event {
+    const char* name;
+    char detail[kDetailSize];
+    uint64_t start;
+    uint64_t end;
+};
+
+// Written only by its owning thread. Buffers are never freed so a dump can
+// still read events from threads that have exited.
+struct ThreadBuffer {
+    uint32_t tid;
+    std::atomic<size_t> count{0};
+    std::array<Event, kBufferSize> events;
+};
+
+std::atomic<bool> g_enabled{false};
+std::atomic<unsigned> g_sample_rate{1};
+volatile std::sig_atomic_t g_dump_requested = 0;
+std::string g_dump_path = "trace.json";
+
+std::mutex g_buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local unsigned t_request_count = 0;
+thread_local bool t_sampled = false;
+
+inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Reference point for converting timestamp counter ticks to microseconds
+struct Epoch {
+    uint64_t ticks;
+    std::chrono::steady_clock::time_point time;
+};
+
+const Epoch& epoch() {
+    static const Epoch value = {now(), std::chrono::steady_clock::now()};
+    return value;
+}
+
+ThreadBuffer* threadBuffer() {
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        g_buffers.push_back(std::make_unique<ThreadBuffer>());
+        g_buffers.back()->tid = static_cast<uint32_t>(g_buffers.size());
+        t_buffer = g_buffers.back().get();
+    }
+    return t_buffer;
+}
+
+void appendEscaped(std::ostringstream& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) >= 0x20) {
+            out << *c;
+        }
+    }
+}
+} // namespace
+
+void setEnabled(bool enabled) {
+    epoch();
+    g_enabled = enabled;
+}
+
+bool isEnabled() {
+    return g_enabled;
+}
+
+void setSampleRate(unsigned rate) {
+    g_sample_rate = rate > 0 ? rate : 1;
+}
+
+unsigned sampleRate() {
+    return g_sample_rate;
+}
+
+void sampleRequest() {
+    t_sampled = g_enabled && t_request_count++ % g_sample_rate == 0;
+}
+
+Span::Span(const char* name) : name_(name), start_(0), active_(t_sampled) {
+    if (active_) {
+        start_ = now();
+    }
+}
+
+Span::Span(const char* name, const std::string& detail) : Span(name) {
+    setDetail(detail);
+}
+
+Span::~Span() {
+    end();
+}
+
+void Span::setDetail(const std::string& detail) {
+    if (active_) {
+        detail_ = detail.substr(0, kDetailSize - 1);
+    }
+}
+
+void Span::end() {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    uint64_t end = now();
+    ThreadBuffer* buffer = threadBuffer();
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index % kBufferSize];
+    event.name = name_;
+    detail_.copy(event.detail, kDetailSize - 1);
+    event.detail[detail_.size()] = '\0';
+    event.start = start_;
+    event.end = end;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+std::string dumpJson() {
+    const Epoch& start = epoch();
+    uint64_t ticks = now();
+    double elapsed_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start.time).count();
+    double ticks_per_us = elapsed_us > 0 ? (ticks - start.ticks) / elapsed_us : 1.0;
+    if (ticks_per_us <= 0) {
+        ticks_per_us = 1.0;
+    }
+
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    for (const auto& buffer : g_buffers) {
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        size_t begin = count > kBufferSize ? count - kBufferSize : 0;
+        for (size_t i = begin; i < count; ++i) {
+            const Event& event = buffer->events[i % kBufferSize];
+            if (event.start < start.ticks) {
+                continue;
+            }
+            if (!first) {
+                out << ",";
+            }
+            first = false;
+            out << "{\"name\":\"";
+            appendEscaped(out, event.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << (event.start - start.ticks) / ticks_per_us
+                << ",\"dur\":" << (event.end - event.start) / ticks_per_us;
+            if (event.detail[0]) {
+                out << ",\"args\":{\"detail\":\"";
+                appendEscaped(out, event.detail);
+                out << "\"}";
+            }
+            out << "}";
+        }
+    }
+
+    out << "],\"displayTimeUnit\":\"ns\"}";
+    return out.str();
+}
+
+void requestDump() {
+    g_dump_requested = 1;
+}
+
+void setDumpPath(const std::string& path) {
+    g_dump_path = path;
+}
+
+void dumpIfRequested() {
+    if (!g_dump_requested) {
+        return;
+    }
+    g_dump_requested = 0;
+    std::ofstream file(g_dump_path);
+    if (!file.is_open()) {
+        std::cerr << "Error writing trace to " << g_dump_path << std::endl;
+        return;
+    }
+    file << dumpJson();
+    std::cout << "Trace written to " << g_dump_path << std::endl;
+}
+} // namespace trace
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Lightweight request tracing. Spans are recorded into fixed-size per-thread
+// ring buffers using the CPU timestamp counter and exported as Chrome
+// trace_event JSON (open in Perfetto or chrome://tracing).
+namespace trace {
+    // Tracing is off until enabled. With a sample rate of N, one request in N
+    // is recorded on each thread.
+    void setEnabled(bool enabled);
+    bool isEnabled();
+    void setSampleRate(unsigned rate);
+    unsigned sampleRate();
+
+    // Decides whether the connection about to be handled on this thread is
+    // recorded. Call once per accepted connection.
+    void sampleRequest();
+
+    // Records the lifetime of the enclosing scope when the current request is
+    // sampled. `name` must be a string literal; `detail` is truncated.
+    class Span {
+    public:
+        explicit Span(const char* name);
+        Span(const char* name, const std::string& detail);
+        ~Span();
+
+        // Attaches detail (e.g. the request path) once it is known
+        void setDetail(const std::string& detail);
+        // Records the span now instead of at scope exit
+        void end();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name_;
+        std::string detail_;
+        uint64_t start_;
+        bool active_;
+    };
+
+    // Every buffered event as a Chrome trace_event JSON document.
+    std::string dumpJson();
+
+    // Async-signal-safe: asks the server loop to write a dump. The loop calls
+    // dumpIfRequested(), which writes dumpJson() to the dump path.
+    void requestDump();
+    void dumpIfRequested();
+    void setDumpPath(const std::string& path);
+}
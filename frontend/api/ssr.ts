@@ -16,23 +16,14 @@ export async function renderSSR(url: string, apiBaseUrl: string): Promise<string
   // Fetch data based on route
   try {
     if (url === '/' || url === '') {
-      // Fetch homepage data
-      const [personalRes, projectsRes, workRes] = await Promise.all([
-        fetch(`${apiBaseUrl}/api/personal`),
-        fetch(`${apiBaseUrl}/api/projects`),
-        fetch(`${apiBaseUrl}/api/work-experience`),
-      ])
+      // Fetch homepage data in one round trip, hydrated under the same key
+      // the landing page queries
+      const res = await fetch(`${apiBaseUrl}/api/bootstrap`)
+      const bootstrap = res.ok ? await res.json() : null
+      const personal = bootstrap?.personal
       
-      const [personal, projects, workExperience] = await Promise.all([
-        personalRes.json(),
-        projectsRes.json(),
-        workRes.json(),
-      ])
-      
-      initialData = {
-        personal,
-        projects,
-        workExperience,
+      if (bootstrap) {
+        initialData = { bootstrap }
       }
       
       if (personal) {
@@ -31,14 +31,8 @@ const queryClient = new QueryClient({
 // Hydrate query cache with SSR data
 if (initialData) {
   // Handle new simplified data structure from SSR
-  if (initialData.personal) {
-    queryClient.setQueryData(['personal'], initialData.personal)
-  }
-  if (initialData.projects) {
-    queryClient.setQueryData(['projects'], initialData.projects)
-  }
-  if (initialData.workExperience) {
-    queryClient.setQueryData(['workExperience'], initialData.workExperience)
+  if (initialData.bootstrap) {
+    queryClient.setQueryData(['bootstrap'], initialData.bootstrap)
   }
   if (initialData.blogPost) {
     // Extract postId from URL
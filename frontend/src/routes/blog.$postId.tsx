@@ -1,6 +1,5 @@
 import { createFileRoute, Link } from '@tanstack/react-router'
 import { useQuery } from '@tanstack/react-query'
-import ReactMarkdown from 'react-markdown'
 import { apiFetch, ApiException } from '../utils/api'
 import { BlogPostSkeleton } from '../components/SkeletonLoader'
 import { SEO } from '../components/SEO'
@@ -11,6 +10,8 @@ interface BlogPost {
   title: string
   excerpt: string
   content: string
+  /** Sanitized HTML rendered from `content` by the backend */
+  html: string
   date: string
   category: string
 }
@@ -127,9 +128,10 @@ function BlogPostDetail() {
 
           <h1 className="article-title">{post.title}</h1>
           
-          <div className="article-content">
-            <ReactMarkdown>{post.content}</ReactMarkdown>
-          </div>
+          <div
+            className="article-content"
+            dangerouslySetInnerHTML={{ __html: post.html }}
+          />
 
           <div className="article-footer">
             <Link to="/blog" className="back-to-blog">
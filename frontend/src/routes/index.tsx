@@ -42,34 +42,35 @@ interface WorkExperience {
   technologies: string[]
 }
 
-/**
- * Fetches personal information from the API.
- * 
- * @returns {Promise<PersonalInfo>} Promise that resolves to personal information object
- * @throws {ApiException} If the API request fails
- */
-async function fetchPersonalInfo(): Promise<PersonalInfo> {
-  return apiFetch<PersonalInfo>('/personal')
+interface BlogPostSummary {
+  id: string
+  title: string
+  excerpt: string
+  date: string
+  category: string
 }
 
 /**
- * Fetches the list of key projects from the API.
- * 
- * @returns {Promise<Project[]>} Promise that resolves to an array of project objects
- * @throws {ApiException} If the API request fails
+ * Everything the landing page renders, served by a single endpoint.
  */
-async function fetchProjects(): Promise<Project[]> {
-  return apiFetch<Project[]>('/projects')
+interface Bootstrap {
+  personal: PersonalInfo
+  projects: Project[]
+  workExperience: WorkExperience[]
+  blog: BlogPostSummary[]
 }
 
 /**
- * Fetches work experience history from the API.
+ * Fetches the landing page data in one request.
+ * 
+ * The backend builds this document (gzip included) once, on first request,
+ * and serves it with an ETag so unchanged data revalidates with a 304.
  * 
- * @returns {Promise<WorkExperience[]>} Promise that resolves to an array of work experience objects
+ * @returns {Promise<Bootstrap>} Promise that resolves to the personal info, projects, work experience and blog posts
  * @throws {ApiException} If the API request fails
  */
-async function fetchWorkExperience(): Promise<WorkExperience[]> {
-  return apiFetch<WorkExperience[]>('/work-experience')
+async function fetchBootstrap(): Promise<Bootstrap> {
+  return apiFetch<Bootstrap>('/bootstrap')
 }
 
 export const Route = createFileRoute('/')({
@@ -143,29 +144,16 @@ function getTechIcon(tech: string): JSX.Element | null {
 }
 
 function Home() {
-  const { data: personalInfo, isLoading: loadingPersonal, error: personalError } = useQuery({
-    queryKey: ['personal'],
-    queryFn: fetchPersonalInfo,
-    retry: 3,
-    retryDelay: (attemptIndex) => Math.min(1000 * 2 ** attemptIndex, 30000),
-  })
-
-  const { data: projects, isLoading: loadingProjects, error: projectsError } = useQuery({
-    queryKey: ['projects'],
-    queryFn: fetchProjects,
-    retry: 3,
-    retryDelay: (attemptIndex) => Math.min(1000 * 2 ** attemptIndex, 30000),
-  })
-
-  const { data: workExperience, isLoading: loadingWork, error: workError } = useQuery({
-    queryKey: ['workExperience'],
-    queryFn: fetchWorkExperience,
+  const { data: bootstrap, isLoading, error } = useQuery({
+    queryKey: ['bootstrap'],
+    queryFn: fetchBootstrap,
     retry: 3,
     retryDelay: (attemptIndex) => Math.min(1000 * 2 ** attemptIndex, 30000),
   })
 
-  const isLoading = loadingPersonal || loadingProjects || loadingWork
-  const hasError = personalError || projectsError || workError
+  const personalInfo = bootstrap?.personal
+  const projects = bootstrap?.projects
+  const workExperience = bootstrap?.workExperience
 
   if (isLoading) {
     return (
@@ -200,8 +188,7 @@ function Home() {
     )
   }
 
-  if (hasError) {
-    const error = personalError || projectsError || workError
+  if (error) {
     const errorMessage = error instanceof ApiException 
       ? error.message 
       : 'Failed to load content. Please try refreshing the page.'
@@ -81,8 +81,7 @@ export default defineConfig({
       output: {
         manualChunks: {
           'react-vendor': ['react', 'react-dom'],
-          'router-vendor': ['@tanstack/react-router', '@tanstack/react-query'],
-          'markdown-vendor': ['react-markdown']
+          'router-vendor': ['@tanstack/react-router', '@tanstack/react-query']
         }
       }
     },